@@ -30,12 +30,15 @@ struct trie_array
 struct trie_tree
 {
   trie_array node_array;
+  trie_array mask_array;  // dictionaries of the word ending at each node, empty until a word is tagged
   //int tail;
 };
 
 struct trie_input
 {
   tchar* str;
+  int len;
+  tdword mask;
   //void* attr;
 };
 
@@ -43,16 +46,19 @@ struct trie_successor
 {
   int base;
   int son;
+  tdword mask;
   //void* attr;
   tchar c;
   tchar active;
 };
 
 static trie_array input_cache;
+static trie_array text_cache;
 static trie_array successor_array;
 static bool be_creating;
 static bool be_inserting;
 static int checking_index;
+static tdword input_mask;
 
 // array function 
 static inline void* get_array_elem(trie_array* in_array, int index)
@@ -89,12 +95,6 @@ static void init_array(trie_array* in_array, int in_elem_size)
   in_array->data = NULL;
 }
 
-static void realloc_array(trie_array* in_array)
-{
-  assert(in_array);
-  in_array->data = (tbyte*)malloc(in_array->max * in_array->elem_size);
-}
-
 static void empty_array(trie_array* in_array)
 {
   assert(in_array);
@@ -110,11 +110,13 @@ static void empty_array(trie_array* in_array)
 void trie_tree_create_begin(int input_num)
 {
   assert( !be_inserting );
-  assert(input_num > 0);
+  assert(input_num >= 0);
   assert(input_cache.len==0);
   assert(successor_array.len==0);
   be_creating = true;
   init_array(&input_cache, sizeof(trie_input));
+  init_array(&text_cache, sizeof(tchar*));
+  input_mask = TRIE_MASK_ALL;
   append_array(&input_cache, input_num);
 }
 
@@ -124,13 +126,160 @@ void trie_tree_set_input(int index, tchar* str)
   assert( be_creating || be_inserting );
   trie_input* input_node = (trie_input*)get_array_elem(&input_cache, index);
   input_node->str = str;
+  input_node->len = 0;
+  while( str[input_node->len] )
+    input_node->len++;
+  input_node->mask = input_mask;
   //input_node->attr = attr;
 }
 
+void trie_tree_set_input_mask(tdword mask)
+{
+  assert( be_creating || be_inserting );
+  input_mask = mask;
+}
+
+// streaming input function
+// empty keys are skipped, duplicate keys are merged by the build itself
+// keys holding a 0 char are skipped too, a 0 son would sit at its parent's base
+static bool append_input(tchar* str, int len)
+{
+  assert( str );
+  assert( be_creating || be_inserting );
+  if( len <= 0 )
+    return false;
+  for(int str_index = 0; str_index<len; str_index++)
+  {
+    if( str[str_index] == 0 )
+      return false;
+  }
+  int index = append_array(&input_cache, 1);
+  trie_input* input_node = (trie_input*)get_array_elem(&input_cache, index);
+  input_node->str = str;
+  input_node->len = len;
+  input_node->mask = input_mask;
+  return true;
+}
+
+int trie_tree_add_keys(tchar* buf, int* offsets, int key_num)
+{
+  assert( buf );
+  assert( offsets );
+  assert( key_num >= 0 );
+  int append_num = 0;
+  for(int key_index = 0; key_index<key_num; key_index++)
+  {
+    assert( offsets[key_index+1] >= offsets[key_index] );
+    if( append_input(buf + offsets[key_index], offsets[key_index+1] - offsets[key_index]) )
+      append_num++;
+  }
+  return append_num;
+}
+
+int trie_tree_add_lines(tchar* text, int len)
+{
+  assert( text );
+  assert( len >= 0 );
+  int append_num = 0;
+  int line_begin = 0;
+  for(int text_index = 0; text_index<=len; text_index++)
+  {
+    if( text_index < len && text[text_index] != L'\n' )
+      continue;
+    int line_end = text_index;
+    if( line_end > line_begin && text[line_end-1] == L'\r' )
+      line_end--;
+    if( append_input(text + line_begin, line_end - line_begin) )
+      append_num++;
+    line_begin = text_index + 1;
+  }
+  return append_num;
+}
+
+// utf-8 to utf-16 in a single pass, code points above U+FFFF become surrogate pairs
+// a malformed sequence rejects its whole line, it is never spliced into a shorter key
+int trie_tree_add_utf8_lines(const char* text, int len)
+{
+  assert( text );
+  assert( len >= 0 );
+  static const tdword min_code[4] = { 0, 0x80, 0x800, 0x10000 };
+  const tbyte* src = (const tbyte*)text;
+  // never more utf-16 units than utf-8 bytes
+  tchar* buf = (tchar*)malloc((len + 1) * sizeof(tchar));
+  int cache_index = append_array(&text_cache, 1);
+  *(tchar**)get_array_elem(&text_cache, cache_index) = buf;
+  int append_num = 0;
+  int src_index = 0, buf_index = 0, line_begin = 0;
+  bool bad_line = false;
+  if( len >= 3 && src[0] == 0xEF && src[1] == 0xBB && src[2] == 0xBF )  // BOM
+    src_index = 3;
+  while( src_index <= len )
+  {
+    tbyte c = src_index < len ? src[src_index] : '\n';
+    if( c == '\n' )
+    {
+      int line_end = buf_index;
+      if( line_end > line_begin && buf[line_end-1] == L'\r' )
+        line_end--;
+      if( bad_line )
+        buf_index = line_begin;
+      else if( append_input(buf + line_begin, line_end - line_begin) )
+        append_num++;
+      line_begin = buf_index;
+      bad_line = false;
+      src_index += 1;
+    }
+    else if( c == 0 )
+    {
+      bad_line = true;
+      src_index += 1;
+    }
+    else if( c < 0x80 )
+    {
+      buf[buf_index++] = c;
+      src_index += 1;
+    }
+    else
+    {
+      int extra = (c & 0xE0) == 0xC0 ? 1 : (c & 0xF0) == 0xE0 ? 2 : (c & 0xF8) == 0xF0 ? 3 : 0;
+      tdword code = c & (0x3F >> extra);
+      int code_index = 1;
+      // stop at the first byte that is not 10xxxxxx, so '\n' is never consumed
+      for( ; code_index<=extra && src_index+code_index < len; code_index++)
+      {
+        tbyte next = src[src_index+code_index];
+        if( (next & 0xC0) != 0x80 )
+          break;
+        code = (code << 6) | (next & 0x3F);
+      }
+      src_index += code_index;
+      if( extra == 0 || code_index <= extra || code < min_code[extra] || code > 0x10FFFF || (code >= 0xD800 && code <= 0xDFFF) )
+        bad_line = true;
+      else if( code >= 0x10000 )
+      {
+        code -= 0x10000;
+        buf[buf_index++] = (tchar)(0xD800 | (code >> 10));
+        buf[buf_index++] = (tchar)(0xDC00 | (code & 0x3FF));
+      }
+      else
+        buf[buf_index++] = (tchar)code;
+    }
+  }
+  return append_num;
+}
+
+static void empty_text_cache()
+{
+  for(int cache_index = 0; cache_index<text_cache.len; cache_index++)
+    free(*(tchar**)get_array_elem(&text_cache, cache_index));
+  empty_array(&text_cache);
+}
+
 void trie_tree_free(trie_tree* tree)
 {
   assert(tree);
   empty_array(&tree->node_array);
+  empty_array(&tree->mask_array);
   free(tree);
 }
 
@@ -166,11 +315,12 @@ static void get_all_successors(tchar* str, int prefix_end, int search_begin_pos)
   successor_array.len = 0;
   for(int i = search_begin_pos; i<input_cache.len; i++)
   {
-    tchar* check_str = ((trie_input*)get_array_elem(&input_cache, i))->str;
+    trie_input* check_input = (trie_input*)get_array_elem(&input_cache, i);
+    tchar* check_str = check_input->str;
     int check_ptr = 0;
-    while( check_ptr < prefix_end && check_str[check_ptr] && check_str[check_ptr] == str[check_ptr] )
+    while( check_ptr < prefix_end && check_ptr < check_input->len && check_str[check_ptr] == str[check_ptr] )
       check_ptr++;
-    if( check_ptr == prefix_end && check_str[prefix_end] && check_successors_unique(check_str[prefix_end]))
+    if( check_ptr == prefix_end && prefix_end < check_input->len && check_successors_unique(check_str[prefix_end]))
     {
       int index = append_array(&successor_array, 1);
       trie_successor* succ = (trie_successor*)get_array_elem(&successor_array, index);
@@ -205,6 +355,44 @@ static void unlink_trie_node(trie_tree* tree, int index)
   node->next = node->prev = index;
 }
 
+// dictionary mask function
+// without mask_array every word belongs to all dictionaries, nodes past its end are 0
+static tdword get_node_mask(trie_tree* tree, int index)
+{
+  assert( tree );
+  if( tree->mask_array.len == 0 )
+    return TRIE_MASK_ALL;
+  if( index >= tree->mask_array.len )
+    return 0;
+  return *(tdword*)get_array_elem(&tree->mask_array, index);
+}
+
+static void set_node_mask(trie_tree* tree, int index, tdword mask)
+{
+  assert( tree );
+  if( tree->mask_array.len == 0 || (mask == 0 && index >= tree->mask_array.len) )
+    return;
+  if( index >= tree->mask_array.len )
+  {
+    int append_index = append_array(&tree->mask_array, index + 1 - tree->mask_array.len);
+    memset(get_array_elem(&tree->mask_array, append_index), 0, (index + 1 - append_index) * sizeof(tdword));
+  }
+  *(tdword*)get_array_elem(&tree->mask_array, index) = mask;
+}
+
+// first tagged word, words marked so far belong to all dictionaries
+static void alloc_node_mask(trie_tree* tree)
+{
+  assert( tree );
+  assert( tree->mask_array.len == 0 );
+  append_array(&tree->mask_array, tree->node_array.len);
+  for(int index = 0; index<tree->node_array.len; index++)
+  {
+    trie_node* node = (trie_node*)get_array_elem(&tree->node_array, index);
+    *(tdword*)get_array_elem(&tree->mask_array, index) = node->base < 0 ? TRIE_MASK_ALL : 0;
+  }
+}
+
 // link to empty_node list
 // index 0 always empty;
 static void empty_trie_node(trie_tree* tree, int node_index)
@@ -215,6 +403,7 @@ static void empty_trie_node(trie_tree* tree, int node_index)
   trie_node* node = (trie_node*)get_array_elem(&tree->node_array, node_index);
   //node->attr = 0;
   node->base = node->check = node->son = 0;
+  set_node_mask(tree, node_index, 0);
   int pre_index = node_index-1;
   while( pre_index >= 0 )
   {
@@ -332,6 +521,7 @@ static void insert_successors(trie_tree* tree, int base_index, int check_index)
     {
       node->base = succ->base;
       node->son = succ->son;
+      set_node_mask(tree, insert_index, succ->mask);
       //node->attr = succ->attr;
       change_son_check_index(tree, insert_index);
     }
@@ -362,6 +552,7 @@ static void reset_successors(trie_tree* tree, int check_index)
       succ->base = son_node->base;
       succ->son = son_node->son;
       succ->c = son_index - abs(check_node->base);
+      succ->mask = get_node_mask(tree, son_index);
       //succ->attr = son_node->attr;
       assert(son_node->next>0);
       son_index = son_node->next;
@@ -375,14 +566,14 @@ static void reset_successors(trie_tree* tree, int check_index)
   }
 }
 
-static bool find_prefix(trie_tree* tree, tchar* str, int* out_prefix_index, int* out_node_index)
+static bool find_prefix(trie_tree* tree, tchar* str, int len, int* out_prefix_index, int* out_node_index)
 {
   assert(tree);
   assert(tree->node_array.len > HEAD_INDEX);
   assert(str);
   int prefix_index = 0;
   int check_index = HEAD_INDEX;
-  while( str[prefix_index] )
+  while( prefix_index < len )
   {
     trie_node* check_node = (trie_node*)get_array_elem(&tree->node_array, check_index);
     if( check_node->base == check_index )
@@ -398,7 +589,7 @@ static bool find_prefix(trie_tree* tree, tchar* str, int* out_prefix_index, int*
   }
   *out_prefix_index = prefix_index;
   *out_node_index = check_index;
-  if( str && str[prefix_index] == 0) // ѳɴ
+  if( prefix_index == len ) // ѳɴ
   {
     assert(prefix_index>0);
     assert(check_index>HEAD_INDEX);
@@ -407,7 +598,7 @@ static bool find_prefix(trie_tree* tree, tchar* str, int* out_prefix_index, int*
   return true;
 }
 
-static void mark_word_node(trie_tree* tree, int index)
+static void mark_word_node(trie_tree* tree, int index, tdword mask)
 {
   assert(tree);
   assert(tree->node_array.len > HEAD_INDEX);
@@ -417,6 +608,9 @@ static void mark_word_node(trie_tree* tree, int index)
   assert(node->base != 0);
   //assert(node->attr == 0);
   //node->attr = attr;
+  if( tree->mask_array.len == 0 && mask != TRIE_MASK_ALL )
+    alloc_node_mask(tree);
+  set_node_mask(tree, index, get_node_mask(tree, index) | mask);
   if( node->base > 0 )
     node->base = -node->base;
 }
@@ -457,6 +651,7 @@ trie_tree* trie_tree_create_end()
   assert(!be_inserting);
   trie_tree* tree = (trie_tree*)malloc(sizeof(trie_tree));
   init_array(&tree->node_array, sizeof(trie_node));
+  init_array(&tree->mask_array, sizeof(tdword));
   init_array(&successor_array, sizeof(trie_successor));
   append_array(&tree->node_array, 2);
   memset(get_array_elem(&tree->node_array, 0), 0, sizeof(trie_node)*2);
@@ -467,16 +662,17 @@ trie_tree* trie_tree_create_end()
   {
     int prefix_index, node_index, base_index;
     trie_input* input_node = (trie_input*)get_array_elem(&input_cache, input_index);
-    while( find_prefix(tree, input_node->str, &prefix_index, &node_index) )
+    while( find_prefix(tree, input_node->str, input_node->len, &prefix_index, &node_index) )
     {
       get_all_successors(input_node->str, prefix_index, input_index);
       base_index = find_base_index_by_successors(tree, node_index);
       insert_successors(tree, base_index, node_index);
     }
-    mark_word_node(tree, node_index);
+    mark_word_node(tree, node_index, input_node->mask);
   }
   empty_array(&input_cache);
   empty_array(&successor_array);
+  empty_text_cache();
   be_creating = false;
   return tree;
 }
@@ -514,14 +710,6 @@ void trie_tree_clear_state(trie_tree* tree)
   checking_index = HEAD_INDEX;
 }
 
-inline tchar to_lower(tchar c)
-{
-  static const tchar sub = 'a' - 'A';
-  if( c >= 'A' && c <= 'Z' )
-    return c + sub;
-  return c;
-}
-
 bool trie_tree_check_string(trie_tree* tree, tchar* str)
 {
   assert(tree);
@@ -558,6 +746,125 @@ bool trie_tree_check_string(trie_tree* tree, tchar* str)
   return is_replace;
 }
 
+tdword trie_tree_check_string_mask(trie_tree* tree, tchar* str, tdword enable_mask, trie_span_callback callback, void* param)
+{
+  assert(tree);
+  assert(str);
+  tdword match_mask = 0;
+  for(int base_index = 0; str[base_index]; base_index++)
+  {
+    int check_index = HEAD_INDEX;
+    for(int state_index = base_index; str[state_index]; state_index++)
+    {
+      trie_node* check_node = (trie_node*)get_array_elem(&tree->node_array, check_index);
+      int next_index = abs(check_node->base) + (int)to_lower(str[state_index]);
+      if( next_index >= tree->node_array.len )
+        break;
+      trie_node* next_node = (trie_node*)get_array_elem(&tree->node_array, next_index);
+      if( next_node->check != check_index )
+        break;
+      check_index = next_index;
+      tdword word_mask = get_node_mask(tree, next_index) & enable_mask;
+      if( next_node->base < 0 && word_mask )
+      {
+        match_mask |= word_mask;
+        if( callback )
+          callback(base_index, state_index+1, word_mask, param);
+      }
+    }
+  }
+  return match_mask;
+}
+
+// approximate match, walk the son lists with one levenshtein row per depth
+struct trie_fuzzy_search
+{
+  trie_tree* tree;
+  tchar* str;
+  int str_len;
+  int max_dist;
+  int* rows;
+  tchar* word;
+  trie_match_callback callback;
+  void* param;
+  int match_num;
+};
+
+static void search_fuzzy_sons(trie_fuzzy_search* search, int check_index, int depth)
+{
+  trie_node* check_node = (trie_node*)get_array_elem(&search->tree->node_array, check_index);
+  int son_index = check_node->son;
+  if( son_index == 0 )
+    return;
+  int row_len = search->str_len + 1;
+  int* prev_row = search->rows + depth * row_len;
+  int* row = prev_row + row_len;
+  do
+  {
+    trie_node* son_node = (trie_node*)get_array_elem(&search->tree->node_array, son_index);
+    assert( son_index > abs(check_node->base) );
+    tchar c = son_index - abs(check_node->base);
+    search->word[depth] = c;
+    row[0] = depth + 1;
+    int min_dist = row[0];
+    for(int i = 1; i<row_len; i++)
+    {
+      int dist = prev_row[i-1] + (search->str[i-1] == c ? 0 : 1);
+      if( prev_row[i] + 1 < dist )
+        dist = prev_row[i] + 1;
+      if( row[i-1] + 1 < dist )
+        dist = row[i-1] + 1;
+      row[i] = dist;
+      if( dist < min_dist )
+        min_dist = dist;
+    }
+    if( son_node->base < 0 && row[row_len-1] <= search->max_dist )
+    {
+      search->word[depth+1] = 0;
+      search->callback(search->word, depth+1, row[row_len-1], search->param);
+      search->match_num++;
+    }
+    // every deeper row is at least min_dist, prune the branch
+    if( min_dist <= search->max_dist )
+      search_fuzzy_sons(search, son_index, depth+1);
+    assert(son_node->next>0);
+    son_index = son_node->next;
+  }
+  while(son_index != check_node->son);
+}
+
+int trie_tree_search_fuzzy(trie_tree* tree, tchar* str, int max_dist, trie_match_callback callback, void* param)
+{
+  assert(tree);
+  assert(str);
+  assert(max_dist >= 0);
+  assert(callback);
+  trie_fuzzy_search search;
+  search.tree = tree;
+  search.str_len = 0;
+  while( str[search.str_len] )
+    search.str_len++;
+  // lowercase the query once, the rows compare against it at every node
+  search.str = (tchar*)malloc((search.str_len + 1) * sizeof(tchar));
+  for(int i = 0; i<=search.str_len; i++)
+    search.str[i] = to_lower(str[i]);
+  search.max_dist = max_dist;
+  search.callback = callback;
+  search.param = param;
+  search.match_num = 0;
+  // a branch deeper than str_len+max_dist is pruned, keep one more row for the last check
+  int max_depth = search.str_len + max_dist + 1;
+  search.rows = (int*)malloc((max_depth + 1) * (search.str_len + 1) * sizeof(int));
+  search.word = (tchar*)malloc((max_depth + 1) * sizeof(tchar));
+  for(int i = 0; i<=search.str_len; i++)
+    search.rows[i] = i;
+  search_fuzzy_sons(&search, HEAD_INDEX, 0);
+  free(search.str);
+  free(search.rows);
+  free(search.word);
+  return search.match_num;
+}
+
 bool check_insert_successors(trie_tree* tree, int check_index)
 {
   assert(tree);
@@ -621,11 +928,13 @@ void delete_existing_successors(trie_tree* tree, int check_index)
 void trie_tree_insert_begin(int input_num)
 {
   assert(!be_creating);
-  assert(input_num > 0);
+  assert(input_num >= 0);
   assert(input_cache.len==0);
   assert(successor_array.len==0);
   be_inserting = true;
   init_array(&input_cache, sizeof(trie_input));
+  init_array(&text_cache, sizeof(tchar*));
+  input_mask = TRIE_MASK_ALL;
   append_array(&input_cache, input_num);
 }
 
@@ -638,7 +947,7 @@ void trie_tree_insert_end(trie_tree* tree)
   {
     int prefix_index, node_index;
     trie_input* input_node = (trie_input*)get_array_elem(&input_cache, input_index);
-    while( find_prefix(tree, input_node->str, &prefix_index, &node_index) )
+    while( find_prefix(tree, input_node->str, input_node->len, &prefix_index, &node_index) )
     {
       int base_index = abs(((trie_node*)get_array_elem(&tree->node_array, node_index))->base);
       get_all_successors(input_node->str, prefix_index, input_index);
@@ -650,34 +959,133 @@ void trie_tree_insert_end(trie_tree* tree)
       }
       insert_successors(tree, base_index, node_index);
     }
-    mark_word_node(tree, node_index);
+    mark_word_node(tree, node_index, input_node->mask);
   }
   print_node(tree, 1, 0);
   empty_array(&input_cache);
   empty_array(&successor_array);
+  empty_text_cache();
   be_inserting = false;
 }
 
 // serialize
+// head, node_len nodes, mask_len masks; blobs of an other layout are rejected
+#define SERIALIZE_MAGIC 0x45495254  // "TRIE"
+#define SERIALIZE_VERSION 2
+
+struct trie_serialize_head
+{
+  tdword magic;
+  tdword version;
+  int node_size;
+  int node_len;
+  int mask_len;
+};
+
 int trie_tree_serialize_len(trie_tree* tree)
 {
-  int array_size = tree->node_array.max * tree->node_array.elem_size;
-  return  array_size + sizeof(trie_tree);
+  assert(tree);
+  return sizeof(trie_serialize_head) + tree->node_array.len * sizeof(trie_node) + tree->mask_array.len * sizeof(tdword);
 }
 
 void trie_tree_serialize(trie_tree* tree, tbyte* buf)
 {
-  int array_size = tree->node_array.max * tree->node_array.elem_size;
-  memcpy(buf, tree, sizeof(trie_tree));
-  memcpy(buf + sizeof(trie_tree), tree->node_array.data, array_size);
+  assert(tree);
+  assert(buf);
+  trie_serialize_head head;
+  head.magic = SERIALIZE_MAGIC;
+  head.version = SERIALIZE_VERSION;
+  head.node_size = sizeof(trie_node);
+  head.node_len = tree->node_array.len;
+  head.mask_len = tree->mask_array.len;
+  memcpy(buf, &head, sizeof(head));
+  buf += sizeof(head);
+  memcpy(buf, tree->node_array.data, head.node_len * sizeof(trie_node));
+  buf += head.node_len * sizeof(trie_node);
+  if( head.mask_len > 0 )
+    memcpy(buf, tree->mask_array.data, head.mask_len * sizeof(tdword));
 }
 
 trie_tree* trie_tree_unserialize(tbyte* buf)
 {
+  assert(buf);
+  trie_serialize_head head;
+  memcpy(&head, buf, sizeof(head));
+  if( head.magic != SERIALIZE_MAGIC || head.version != SERIALIZE_VERSION || head.node_size != sizeof(trie_node) )
+    return NULL;
+  if( head.node_len <= HEAD_INDEX || head.mask_len < 0 )
+    return NULL;
+  buf += sizeof(head);
   trie_tree* tree = (trie_tree*)malloc(sizeof(trie_tree));
-  memcpy(tree, buf, sizeof(trie_tree));
-  int array_size = tree->node_array.max * tree->node_array.elem_size;
-  realloc_array(&tree->node_array);
-  memcpy(tree->node_array.data, buf + sizeof(trie_tree), array_size);
+  init_array(&tree->node_array, sizeof(trie_node));
+  init_array(&tree->mask_array, sizeof(tdword));
+  append_array(&tree->node_array, head.node_len);
+  memcpy(tree->node_array.data, buf, head.node_len * sizeof(trie_node));
+  buf += head.node_len * sizeof(trie_node);
+  if( head.mask_len > 0 )
+  {
+    append_array(&tree->mask_array, head.mask_len);
+    memcpy(tree->mask_array.data, buf, head.mask_len * sizeof(tdword));
+  }
   return tree;
 }
+
+// code generation
+static void write_int_array(FILE* file, const char* name, const char* field, trie_tree* tree, int node_len, bool is_base)
+{
+  fprintf(file, "inline constexpr int %s_%s[%d] =\n{", name, field, node_len);
+  for(int index = 0; index<node_len; index++)
+  {
+    trie_node* node = (trie_node*)get_array_elem(&tree->node_array, index);
+    if( index % 16 == 0 )
+      fprintf(file, "\n  ");
+    fprintf(file, "%d,", is_base ? node->base : node->check);
+  }
+  fprintf(file, "\n};\n\n");
+}
+
+static void write_mask_array(FILE* file, const char* name, trie_tree* tree, int node_len)
+{
+  fprintf(file, "inline constexpr tdword %s_mask[%d] =\n{", name, node_len);
+  for(int index = 0; index<node_len; index++)
+  {
+    if( index % 16 == 0 )
+      fprintf(file, "\n  ");
+    fprintf(file, "0x%x,", get_node_mask(tree, index));
+  }
+  fprintf(file, "\n};\n\n");
+}
+
+bool trie_tree_generate_header(trie_tree* tree, const char* name, const char* path)
+{
+  assert(tree);
+  assert(name);
+  assert(path);
+  FILE* file = fopen(path, "w");
+  if( !file )
+    return false;
+  // trailing empty nodes never match a check, cut them off
+  int node_len = tree->node_array.len;
+  while( node_len > HEAD_INDEX+1 && is_empty_trie_node((trie_node*)get_array_elem(&tree->node_array, node_len-1)) )
+    node_len--;
+  fprintf(file, "// generated by trie_tree_generate_header, do not edit\n");
+  fprintf(file, "// needs c++17, the tables are inline variables shared by every translation unit\n");
+  fprintf(file, "#pragma once\n\n#include \"Trie.h\"\n\n");
+  write_int_array(file, name, "base", tree, node_len, true);
+  write_int_array(file, name, "check", tree, node_len, false);
+  // an untagged trie gets no mask table, every word belongs to all dictionaries
+  bool has_mask = tree->mask_array.len > 0;
+  if( has_mask )
+    write_mask_array(file, name, tree, node_len);
+  fprintf(file, "inline void %s_clear_state(int* checking_index)\n{\n  *checking_index = %d;\n}\n\n", name, HEAD_INDEX);
+  fprintf(file, "inline TRIE_STATE %s_check_state(int* checking_index, tchar c)\n{\n"
+                "  return trie_static_check_state(%s_base, %s_check, checking_index, c);\n}\n\n", name, name, name);
+  fprintf(file, "inline bool %s_check_string(tchar* str)\n{\n"
+                "  return trie_static_check_string(%s_base, %s_check, str);\n}\n", name, name, name);
+  if( has_mask )
+    fprintf(file, "\ninline tdword %s_check_string_mask(tchar* str, tdword enable_mask, trie_span_callback callback, void* param)\n{\n"
+                  "  return trie_static_check_string_mask(%s_base, %s_check, %s_mask, str, enable_mask, callback, param);\n}\n", name, name, name, name);
+  bool result = !ferror(file);
+  fclose(file);
+  return result;
+}
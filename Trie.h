@@ -1,3 +1,4 @@
+#pragma once
 
 // double array trie tree
 
@@ -7,6 +8,8 @@ typedef unsigned int tdword;
 
 struct trie_tree;
 
+#define TRIE_MASK_ALL 0xffffffff
+
 typedef enum 
 {
   STATE_NULL = 0,
@@ -15,6 +18,15 @@ typedef enum
   STATE_WORD_PREFIX = 3,
 } TRIE_STATE;
 
+// case folding shared by the runtime and the static matchers
+inline tchar to_lower(tchar c)
+{
+  static const tchar sub = 'a' - 'A';
+  if( c >= 'A' && c <= 'Z' )
+    return c + sub;
+  return c;
+}
+
 // create function
 void trie_tree_create_begin(int input_num);
 
@@ -25,6 +37,20 @@ void trie_tree_free(trie_tree* tree);
 // set input function
 void trie_tree_set_input(int index, tchar* str);
 
+// dictionary mask of the following inputs, one bit per dictionary
+// reset to TRIE_MASK_ALL by create_begin/insert_begin, a word in several dictionaries keeps every bit
+void trie_tree_set_input_mask(tdword mask);
+
+// streaming input function, append keys after create_begin/insert_begin
+// keys are used in place and must stay valid until create_end/insert_end
+// empty keys and keys holding a 0 char are skipped, duplicate keys are allowed
+// return the number of keys appended
+int trie_tree_add_keys(tchar* buf, int* offsets, int key_num);  // key i is buf[offsets[i]..offsets[i+1])
+
+int trie_tree_add_lines(tchar* text, int len);  // '\n' or "\r\n" delimited, text may be a mapped file
+
+int trie_tree_add_utf8_lines(const char* text, int len);  // transcoded into one buffer freed by create_end/insert_end, malformed lines and lines with a 0 byte are skipped
+
 //DFA function
 TRIE_STATE trie_tree_check_state(trie_tree* tree, tchar c);
 
@@ -32,6 +58,18 @@ void trie_tree_clear_state(trie_tree* tree);
 
 bool trie_tree_check_string(trie_tree* tree, tchar* str);
 
+// multi dictionary function, report every word of an enabled dictionary as str[begin..end)
+// return the mask of all matched dictionaries, callback may be NULL
+typedef void (*trie_span_callback)(int begin, int end, tdword mask, void* param);
+
+tdword trie_tree_check_string_mask(trie_tree* tree, tchar* str, tdword enable_mask, trie_span_callback callback, void* param);
+
+// approximate match function, report every word within max_dist edits of str
+// word is only valid during the callback, copy it to keep it
+typedef void (*trie_match_callback)(tchar* word, int len, int dist, void* param);
+
+int trie_tree_search_fuzzy(trie_tree* tree, tchar* str, int max_dist, trie_match_callback callback, void* param);
+
 // insert and remove function
 void trie_tree_insert_begin(int input_num);
 
@@ -42,5 +80,80 @@ int trie_tree_serialize_len(trie_tree* tree);
 
 void trie_tree_serialize(trie_tree* tree, tbyte* buf);
 
-trie_tree* trie_tree_unserialize(tbyte* buf);
+trie_tree* trie_tree_unserialize(tbyte* buf);  // NULL if buf was not written by this version of trie_tree_serialize
+
+// code generation, write the base/check arrays as a static header
+bool trie_tree_generate_header(trie_tree* tree, const char* name, const char* path);
 
+// static trie function, used by generated headers
+// checking_index starts at 1 (head node)
+template<int N>
+inline TRIE_STATE trie_static_check_state(const int (&base)[N], const int (&check)[N], int* checking_index, tchar c)
+{
+  int checking_base = base[*checking_index];
+  int next_index = (checking_base < 0 ? -checking_base : checking_base) + (int)c;
+  if( next_index >= N || check[next_index] != *checking_index )
+    return STATE_NULL;
+  *checking_index = next_index;
+  if( base[next_index] == -next_index )
+    return STATE_WORD;
+  if( base[next_index] < 0 )
+    return STATE_WORD_PREFIX;
+  return STATE_PREFIX;
+}
+
+template<int N>
+inline bool trie_static_check_string(const int (&base)[N], const int (&check)[N], tchar* str)
+{
+  int state_index, base_index = 0;
+  bool is_replace = false;
+  while( str[base_index] )
+  {
+    int checking_index = 1;
+    state_index = base_index;
+    while( str[state_index] )
+    {
+      TRIE_STATE state = trie_static_check_state(base, check, &checking_index, to_lower(str[state_index]));
+      if( state == STATE_NULL )
+        break;
+      if( state == STATE_WORD || state == STATE_WORD_PREFIX )
+      {
+        for(int replace_index = base_index; replace_index<=state_index; replace_index++)
+          str[replace_index] = L'*';
+        is_replace = true;
+        if( state == STATE_WORD )
+        {
+          base_index = state_index;
+          break;
+        }
+      }
+      state_index++;
+    }
+    base_index++;
+  }
+  return is_replace;
+}
+
+template<int N>
+inline tdword trie_static_check_string_mask(const int (&base)[N], const int (&check)[N], const tdword (&mask)[N], tchar* str, tdword enable_mask, trie_span_callback callback, void* param)
+{
+  tdword match_mask = 0;
+  for(int base_index = 0; str[base_index]; base_index++)
+  {
+    int checking_index = 1;
+    for(int state_index = base_index; str[state_index]; state_index++)
+    {
+      TRIE_STATE state = trie_static_check_state(base, check, &checking_index, to_lower(str[state_index]));
+      if( state == STATE_NULL )
+        break;
+      tdword word_mask = mask[checking_index] & enable_mask;
+      if( (state == STATE_WORD || state == STATE_WORD_PREFIX) && word_mask )
+      {
+        match_mask |= word_mask;
+        if( callback )
+          callback(base_index, state_index+1, word_mask, param);
+      }
+    }
+  }
+  return match_mask;
+}
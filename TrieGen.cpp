@@ -0,0 +1,63 @@
+
+// generate a static trie header from a utf-8 word list, one word per line
+// usage: TrieGen <name> <header file> <word file> [<word file> ...]
+// with several word files the k-th one is dictionary k, its words get mask bit 1<<k
+// a single word file stays untagged, so the header carries no mask table
+
+#include "Trie.h"
+#include <stdlib.h>
+#include <stdio.h>
+
+static char* read_file(const char* path, int* out_len)
+{
+  FILE* file = fopen(path, "rb");
+  if( !file )
+    return NULL;
+  fseek(file, 0, SEEK_END);
+  int len = (int)ftell(file);
+  fseek(file, 0, SEEK_SET);
+  char* text = (char*)malloc(len + 1);
+  *out_len = (int)fread(text, 1, len, file);
+  fclose(file);
+  return text;
+}
+
+int main(int argc, char* argv[])
+{
+  if( argc < 4 || argc > 4 + 31 )
+  {
+    fprintf(stderr, "usage: TrieGen <name> <header file> <word file> [<word file> ...]\n");
+    return 1;
+  }
+  trie_tree_create_begin(0);
+  for(int dict_index = 0; dict_index < argc - 3; dict_index++)
+  {
+    const char* path = argv[3 + dict_index];
+    int text_len;
+    char* text = read_file(path, &text_len);
+    if( !text )
+    {
+      fprintf(stderr, "can not read %s\n", path);
+      return 1;
+    }
+    // the loader copies into its own buffer, text can go right away
+    if( argc > 4 )
+      trie_tree_set_input_mask(1u << dict_index);
+    int word_num = trie_tree_add_utf8_lines(text, text_len);
+    free(text);
+    if( word_num == 0 )
+    {
+      fprintf(stderr, "no word in %s\n", path);
+      return 1;
+    }
+  }
+  trie_tree* tree = trie_tree_create_end();
+  bool result = trie_tree_generate_header(tree, argv[1], argv[2]);
+  trie_tree_free(tree);
+  if( !result )
+  {
+    fprintf(stderr, "can not write %s\n", argv[2]);
+    return 1;
+  }
+  return 0;
+}